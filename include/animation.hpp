@@ -0,0 +1,203 @@
+#pragma once
+
+#include <Arduino.h>
+#include <vector>
+
+#define ANIM_NAME_LEN 16
+#define ANIM_MAX_EVENTS 8
+#define ANIM_NO_EVENT -1
+
+// A clip compiled to flat per-tick tables: advancing is a single lookup.
+struct AnimationClip
+{
+    char name[ANIM_NAME_LEN];
+    bool loop = true;
+    std::vector<uint8_t> frames; // frame index for every tick
+    std::vector<int8_t> events;  // event id fired on every tick, ANIM_NO_EVENT if none
+
+    size_t length() const
+    {
+        return frames.size();
+    }
+
+    uint8_t frameAt(size_t tick) const
+    {
+        if (frames.empty())
+            return 0;
+        return frames[loop ? tick % frames.size() : min(tick, frames.size() - 1)];
+    }
+
+    int eventAt(size_t tick) const
+    {
+        if (events.empty() || (!loop && tick >= events.size()))
+            return ANIM_NO_EVENT;
+        return events[tick % events.size()];
+    }
+};
+
+// Clips of one sprite, declared in a text file next to its .bin, one clip per line:
+//   clip: <name> frames=0,1,2 durations=1[,2,..] mode=loop|hold [events=<frame>:<event>,..]
+// durations are in ticks, a single value applies to every frame. <frame> in events is a position in frames=,
+// the event fires on the first tick of that frame.
+class AnimationSet
+{
+public:
+    // clips matching the original hard-coded Fish behaviour
+    void setupDefault(size_t frameCount)
+    {
+        std::vector<uint8_t> frames;
+        for (size_t i = 0; i < frameCount; i++)
+            frames.push_back(i);
+        std::vector<uint8_t> one = {1}, two = {2};
+        std::vector<uint8_t> turn = {0};
+        compile("dash", frames, one, true, {});
+        compile("float", frames, two, true, {});
+        // no flip event: Fish mirrors on the TURNING -> DASHING transition, as before
+        compile("turn", turn, one, false, {});
+    }
+
+    // parse clip declarations, clips with an existing name are replaced in place
+    bool setup(const char *text, size_t size)
+    {
+        std::vector<char> buf(text, text + size);
+        buf.push_back('\0');
+        bool ok = true;
+        char *save = nullptr;
+        for (char *line = strtok_r(buf.data(), "\r\n", &save); line; line = strtok_r(nullptr, "\r\n", &save))
+        {
+            while (*line == ' ' || *line == '\t')
+                line++;
+            if (strncmp(line, "clip:", 5) != 0)
+                continue;
+            if (!parseClip(line + 5))
+            {
+                Serial.println("Bad animation clip: " + String(line));
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    int findClip(const char *name) const
+    {
+        for (size_t i = 0; i < m_clips.size(); i++)
+        {
+            if (strncmp(m_clips[i].name, name, ANIM_NAME_LEN) == 0)
+                return i;
+        }
+        return -1;
+    }
+
+    const AnimationClip &getClip(size_t index) const
+    {
+        return m_clips[index];
+    }
+
+    int getEventId(const char *name) const
+    {
+        for (size_t i = 0; i < m_eventCount; i++)
+        {
+            if (strncmp(m_events[i], name, ANIM_NAME_LEN) == 0)
+                return i;
+        }
+        return ANIM_NO_EVENT;
+    }
+
+private:
+    std::vector<AnimationClip> m_clips;
+    char m_events[ANIM_MAX_EVENTS][ANIM_NAME_LEN];
+    size_t m_eventCount = 0;
+
+    int addEvent(const char *name)
+    {
+        int id = getEventId(name);
+        if (id != ANIM_NO_EVENT || m_eventCount >= ANIM_MAX_EVENTS)
+            return id;
+        strncpy(m_events[m_eventCount], name, ANIM_NAME_LEN - 1);
+        m_events[m_eventCount][ANIM_NAME_LEN - 1] = '\0';
+        return m_eventCount++;
+    }
+
+    static void parseList(const char *s, std::vector<uint8_t> &out)
+    {
+        while (*s && *s != ' ')
+        {
+            out.push_back((uint8_t)atoi(s));
+            while (*s && *s != ',' && *s != ' ')
+                s++;
+            if (*s == ',')
+                s++;
+        }
+    }
+
+    bool parseClip(char *decl)
+    {
+        char name[ANIM_NAME_LEN] = {0};
+        std::vector<uint8_t> frames, durations;
+        std::vector<std::pair<uint8_t, int8_t>> events;
+        bool loop = true;
+
+        char *save = nullptr;
+        for (char *tok = strtok_r(decl, " \t", &save); tok; tok = strtok_r(nullptr, " \t", &save))
+        {
+            if (strncmp(tok, "frames=", 7) == 0)
+                parseList(tok + 7, frames);
+            else if (strncmp(tok, "durations=", 10) == 0)
+                parseList(tok + 10, durations);
+            else if (strncmp(tok, "mode=", 5) == 0)
+                loop = strcmp(tok + 5, "hold") != 0;
+            else if (strncmp(tok, "events=", 7) == 0)
+            {
+                // <frame>:<event>,<frame>:<event>
+                char *evSave = nullptr;
+                for (char *ev = strtok_r(tok + 7, ",", &evSave); ev; ev = strtok_r(nullptr, ",", &evSave))
+                {
+                    char *colon = strchr(ev, ':');
+                    if (!colon)
+                        return false;
+                    *colon = '\0';
+                    int id = addEvent(colon + 1);
+                    if (id == ANIM_NO_EVENT)
+                        return false;
+                    events.push_back({(uint8_t)atoi(ev), (int8_t)id});
+                }
+            }
+            else if (name[0] == '\0')
+                strncpy(name, tok, ANIM_NAME_LEN - 1);
+        }
+
+        if (name[0] == '\0' || frames.empty() || durations.empty())
+            return false;
+        if (durations.size() != 1 && durations.size() != frames.size())
+            return false;
+        compile(name, frames, durations, loop, events);
+        return true;
+    }
+
+    void compile(const char *name, const std::vector<uint8_t> &frames, const std::vector<uint8_t> &durations, bool loop,
+                 const std::vector<std::pair<uint8_t, int8_t>> &events)
+    {
+        AnimationClip clip;
+        strncpy(clip.name, name, ANIM_NAME_LEN - 1);
+        clip.name[ANIM_NAME_LEN - 1] = '\0';
+        clip.loop = loop;
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            size_t start = clip.frames.size();
+            uint8_t duration = max((uint8_t)1, durations.size() == 1 ? durations[0] : durations[i]);
+            clip.frames.insert(clip.frames.end(), duration, frames[i]);
+            clip.events.insert(clip.events.end(), duration, (int8_t)ANIM_NO_EVENT);
+            for (auto &e : events)
+            {
+                if (e.first == i)
+                    clip.events[start] = e.second;
+            }
+        }
+
+        int index = findClip(clip.name);
+        if (index >= 0)
+            m_clips[index] = clip;
+        else
+            m_clips.push_back(clip);
+    }
+};
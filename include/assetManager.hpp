@@ -0,0 +1,168 @@
+#pragma once
+
+#include <Arduino.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "utils.hpp"
+
+#define ASSET_TASK_STACK 4096
+#define ASSET_TASK_CORE 0 // loop() 跑在 core 1
+
+typedef int AssetHandle;
+
+// Where asset bytes come from. Override to simulate slow storage when testing.
+class FileBackend
+{
+public:
+    virtual ~FileBackend() {}
+    virtual bool load(const char *path, uint8_t *&data, size_t &size)
+    {
+        return loadFilePsram(path, data, size);
+    }
+};
+
+// Adds a fixed delay before every file, e.g. to check progressive boot.
+class SlowFileBackend : public FileBackend
+{
+public:
+    SlowFileBackend(uint32_t delayMs) : m_delayMs(delayMs) {}
+
+    bool load(const char *path, uint8_t *&data, size_t &size) override
+    {
+        delay(m_delayMs);
+        return FileBackend::load(path, data, size);
+    }
+
+private:
+    uint32_t m_delayMs;
+};
+
+// Loads assets on a background task in priority order (lower first).
+// Ready callbacks run from poll() on the caller's thread and take ownership of the data.
+class AssetManager
+{
+public:
+    enum state : uint8_t
+    {
+        PENDING,
+        READY,
+        DONE, // callback already ran
+        FAILED
+    };
+
+    typedef std::function<void(uint8_t *data, size_t size)> ReadyCallback;
+
+    AssetHandle add(const char *path, uint8_t priority, ReadyCallback onReady)
+    {
+        if (m_task != nullptr)
+        {
+            Serial.println("Cannot add assets after loading started");
+            return -1;
+        }
+        m_assets.emplace_back();
+        Asset &a = m_assets.back();
+        a.path = path;
+        a.priority = priority;
+        a.onReady = onReady;
+        return m_assets.size() - 1;
+    }
+
+    void start(FileBackend *backend = nullptr)
+    {
+        m_backend = backend ? backend : &m_defaultBackend;
+        m_order.clear();
+        for (size_t i = 0; i < m_assets.size(); i++)
+            m_order.push_back(i);
+        std::stable_sort(m_order.begin(), m_order.end(), [this](size_t a, size_t b) {
+            return m_assets[a].priority < m_assets[b].priority;
+        });
+
+        m_startMs = millis();
+        xTaskCreatePinnedToCore(loaderTask, "assets", ASSET_TASK_STACK, this, 1, &m_task, ASSET_TASK_CORE);
+    }
+
+    // Run ready callbacks for everything loaded since the last call.
+    void poll()
+    {
+        for (Asset &a : m_assets)
+        {
+            if (a.state.load() != READY)
+                continue;
+            if (a.onReady)
+                a.onReady(a.data, a.size);
+            a.state = DONE;
+            m_doneCount++;
+            Serial.println("asset ready: " + String(a.path) + " at " + String(a.loadedMs - m_startMs) + " ms");
+        }
+    }
+
+    bool isReady(AssetHandle h) const
+    {
+        return h >= 0 && h < (int)m_assets.size() && m_assets[h].state.load() == DONE;
+    }
+
+    // every asset has either been delivered or failed
+    bool allDone() const
+    {
+        for (const Asset &a : m_assets)
+        {
+            uint8_t s = a.state.load();
+            if (s != DONE && s != FAILED)
+                return false;
+        }
+        return true;
+    }
+
+    // grows every time poll() delivers an asset
+    size_t getDoneCount() const
+    {
+        return m_doneCount;
+    }
+
+    uint32_t getStartMs() const
+    {
+        return m_startMs;
+    }
+
+private:
+    struct Asset
+    {
+        const char *path = nullptr;
+        uint8_t priority = 0;
+        ReadyCallback onReady;
+        uint8_t *data = nullptr;
+        size_t size = 0;
+        uint32_t loadedMs = 0;
+        std::atomic<uint8_t> state{PENDING};
+
+        Asset() {}
+        Asset(Asset &&o) : path(o.path), priority(o.priority), onReady(o.onReady), data(o.data), size(o.size), loadedMs(o.loadedMs), state(o.state.load()) {}
+    };
+
+    std::vector<Asset> m_assets;
+    std::vector<size_t> m_order;
+    FileBackend m_defaultBackend;
+    FileBackend *m_backend = nullptr;
+    TaskHandle_t m_task = nullptr;
+    uint32_t m_startMs = 0;
+    size_t m_doneCount = 0;
+
+    static void loaderTask(void *arg)
+    {
+        AssetManager *self = (AssetManager *)arg;
+        for (size_t i : self->m_order)
+        {
+            Asset &a = self->m_assets[i];
+            bool ok = self->m_backend->load(a.path, a.data, a.size);
+            a.loadedMs = millis();
+            if (!ok)
+            {
+                Serial.println("Failed to load asset " + String(a.path));
+            }
+            // publish data before the state the loop thread polls
+            a.state.store(ok ? READY : FAILED);
+        }
+        vTaskDelete(nullptr);
+    }
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <Arduino.h>
+#include "colorMap.hpp"
+
+#define BLEND_LEVELS 3                 // alpha = (level + 1) / (BLEND_LEVELS + 1)，即 25% 50% 75%
+#define BLEND_ENTRIES (COLOR_COUNT + 1) // 0 = 底下没有东西时的清屏色
+
+// blend two byte-swapped rgb565 colors, alpha in 0~256 is the weight of src
+inline uint16_t blend565(uint16_t src, uint16_t dst, uint32_t alpha)
+{
+    uint16_t s = __builtin_bswap16(src);
+    uint16_t d = __builtin_bswap16(dst);
+    uint32_t r = (((s >> 11) & 0x1F) * alpha + ((d >> 11) & 0x1F) * (256 - alpha)) >> 8;
+    uint32_t g = (((s >> 5) & 0x3F) * alpha + ((d >> 5) & 0x3F) * (256 - alpha)) >> 8;
+    uint32_t b = ((s & 0x1F) * alpha + (d & 0x1F) * (256 - alpha)) >> 8;
+    return __builtin_bswap16((r << 11) | (g << 5) | b);
+}
+
+// Precomputed src-over-dst results for every pair of palette indices at a few alpha levels,
+// so blending two indexed pixels is one lookup. Only rows/columns of changed colors are rebuilt.
+class BlendTable
+{
+public:
+    void setup()
+    {
+        if (m_table == nullptr)
+        {
+            // 查表频繁，放内部 RAM
+            m_table = (uint16_t *)malloc(BLEND_LEVELS * BLEND_ENTRIES * BLEND_ENTRIES * 2);
+        }
+    }
+
+    // returns number of palette entries that changed
+    size_t update(const ColorMap &colorMap, uint16_t clearColor)
+    {
+        if (m_table == nullptr)
+            return 0;
+        if (m_colorMap == &colorMap && m_paletteVersion == colorMap.getVersion() && m_colors[0] == clearColor && m_built)
+            return 0;
+
+        bool dirty[BLEND_ENTRIES];
+        size_t changed = 0;
+        for (size_t i = 0; i < BLEND_ENTRIES; i++)
+        {
+            uint16_t color = i == 0 ? clearColor : colorMap.getColor(i);
+            dirty[i] = !m_built || color != m_colors[i];
+            m_colors[i] = color;
+            if (dirty[i])
+                changed++;
+        }
+
+        for (size_t level = 0; level < BLEND_LEVELS; level++)
+        {
+            uint32_t alpha = getAlpha(level);
+            uint16_t *t = m_table + level * BLEND_ENTRIES * BLEND_ENTRIES;
+            for (size_t s = 0; s < BLEND_ENTRIES; s++)
+            {
+                for (size_t d = 0; d < BLEND_ENTRIES; d++)
+                {
+                    if (dirty[s] || dirty[d])
+                        t[s * BLEND_ENTRIES + d] = blend565(m_colors[s], m_colors[d], alpha);
+                }
+            }
+        }
+
+        m_built = true;
+        m_colorMap = &colorMap;
+        m_paletteVersion = colorMap.getVersion();
+        return changed;
+    }
+
+    inline uint16_t blend(size_t level, uint8_t src, uint8_t dst) const
+    {
+        return m_table[(level * BLEND_ENTRIES + src) * BLEND_ENTRIES + dst];
+    }
+
+    static uint32_t getAlpha(size_t level)
+    {
+        return 256 * (level + 1) / (BLEND_LEVELS + 1);
+    }
+
+    uint16_t getColor(uint8_t index) const
+    {
+        return m_colors[index];
+    }
+
+    ~BlendTable()
+    {
+        if (m_table)
+        {
+            free(m_table);
+            m_table = nullptr;
+        }
+    }
+
+private:
+    uint16_t *m_table = nullptr;
+    uint16_t m_colors[BLEND_ENTRIES] = {0};
+    bool m_built = false;
+    const ColorMap *m_colorMap = nullptr;
+    uint32_t m_paletteVersion = 0;
+};
+
+// Times table lookups against per-pixel arithmetic blending over one framebuffer worth of pixels.
+inline void benchmarkBlend(const ColorMap &colorMap, uint16_t clearColor)
+{
+    const size_t pixels = 160 * 120;
+    BlendTable table;
+    table.setup();
+    uint32_t start = micros();
+    table.update(colorMap, clearColor);
+    uint32_t build_us = micros() - start;
+
+    uint8_t *src = (uint8_t *)ps_malloc(pixels);
+    uint8_t *dst = (uint8_t *)ps_malloc(pixels);
+    uint16_t *out = (uint16_t *)ps_malloc(pixels * 2);
+    if (!src || !dst || !out)
+    {
+        Serial.println("Failed to allocate blend benchmark buffers");
+        free(src);
+        free(dst);
+        free(out);
+        return;
+    }
+    for (size_t i = 0; i < pixels; i++)
+    {
+        src[i] = random(1, BLEND_ENTRIES);
+        dst[i] = random(0, BLEND_ENTRIES);
+    }
+
+    start = micros();
+    for (size_t i = 0; i < pixels; i++)
+        out[i] = table.blend(1, src[i], dst[i]);
+    uint32_t table_us = micros() - start;
+
+    uint32_t alpha = BlendTable::getAlpha(1);
+    start = micros();
+    for (size_t i = 0; i < pixels; i++)
+        out[i] = blend565(table.getColor(src[i]), table.getColor(dst[i]), alpha);
+    uint32_t arith_us = micros() - start;
+
+    Serial.println("blend benchmark (" + String(pixels) + " px): table " + String(table_us) + " us, arithmetic " +
+                   String(arith_us) + " us, table build " + String(build_us) + " us");
+    free(src);
+    free(dst);
+    free(out);
+}
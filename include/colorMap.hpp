@@ -20,6 +20,7 @@ public:
         {
             memcpy(m_color, color, size);
         }
+        m_version++;
     }
 
     void setup(const char *path)
@@ -32,6 +33,7 @@ public:
         {
             Serial.println("Color map size mismatch");
         }
+        m_version++;
     }
 
     void copy(const ColorMap &c)
@@ -44,6 +46,7 @@ public:
             {
                 memcpy(m_color, c.m_color, m_size);
             }
+            m_version++;
         }
     }
 
@@ -72,6 +75,7 @@ public:
             uint8_t b = (uint8_t)(b1 * (1 - ratio) + b2 * ratio);
             m_color[i] = __builtin_bswap16((r << 11) | (g << 5) | b);
         }
+        m_version++;
     }
 
     void mix(ColorMap &dst, const ColorMap &c1, const ColorMap &c2, float ratio)
@@ -94,6 +98,27 @@ public:
             uint8_t b = (uint8_t)(b1 * (1 - ratio) + b2 * ratio);
             dst.m_color[i] = __builtin_bswap16((r << 11) | (g << 5) | b);
         }
+        dst.m_version++;
+    }
+
+    // dst = src with brightness & color temperature applied, same curve as applyDayNight
+    void tint(const ColorMap &src, float brightness, float r_scale, float g_scale, float b_scale)
+    {
+        if (!m_color || !src.m_color || m_size != src.m_size)
+            return;
+
+        for (size_t i = 0; i < COLOR_COUNT; i++)
+        {
+            uint16_t c = __builtin_bswap16(src.m_color[i]);
+            uint8_t r = ((c >> 11) & 0x1F) << 3;
+            uint8_t g = ((c >> 5) & 0x3F) << 2;
+            uint8_t b = (c & 0x1F) << 3;
+            r = std::min(255, int(r * r_scale * brightness));
+            g = std::min(255, int(g * g_scale * brightness));
+            b = std::min(255, int(b * b_scale * brightness));
+            m_color[i] = __builtin_bswap16(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+        }
+        m_version++;
     }
 
     void getColorRGB(uint8_t index, uint8_t &r, uint8_t &g, uint8_t &b) const
@@ -110,14 +135,20 @@ public:
 
     uint16_t getColor(uint8_t index) const
     {
-        uint16_t color = m_color[index-1];
         if (!m_color || index == 0 || index > COLOR_COUNT)
             return COLOR_TRANSPARENT;
-        return color;
+        return m_color[index - 1];
+    }
+
+    // bumped on every color change, caches compare it to know when to rebuild
+    uint32_t getVersion() const
+    {
+        return m_version;
     }
 
 private:
     // use rgb565
-    uint16_t *m_color;
+    uint16_t *m_color = nullptr;
     size_t m_size = 0;
+    uint32_t m_version = 0;
 };
\ No newline at end of file
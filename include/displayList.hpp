@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include "renderer.hpp"
+#include "colorMap.hpp"
+#include "spriteData.hpp"
+#include <LovyanGFX.hpp>
+
+#define DISPLAY_LIST_CAPACITY 64 // 每帧最多的绘制命令数
+#define DISPLAY_LIST_SPRITES 16  // 参与排序键的 SpriteData 数
+
+// draw order from back to front
+enum DrawLayer : uint8_t
+{
+    LAYER_BACKGROUND = 0,
+    LAYER_FISH = 1,
+    LAYER_FOREGROUND = 2,
+    LAYER_OVERLAY = 3
+};
+
+struct DrawCommand
+{
+    SpriteData *sprite;
+    ColorMap *colorMap;
+    uint32_t offset; // byte offset of the frame in sprite
+    int16_t x;       // center, same as GameObject::setPos
+    int16_t y;
+    uint8_t w;
+    uint8_t h;
+    uint8_t layer;
+    uint8_t depth; // larger = nearer
+    bool flipX;
+    uint32_t key;
+};
+
+// Per-frame command buffer: objects submit, the list sorts by packed key
+// (layer, depth, sprite), culls and blits indexed pixels straight into the framebuffer.
+class DisplayList
+{
+public:
+    struct Stats
+    {
+        uint32_t submitted;
+        uint32_t culledViewport;
+        uint32_t culledOccluded;
+        uint32_t drawn;
+    };
+
+    void begin()
+    {
+        m_count = 0;
+        m_stats = {0, 0, 0, 0};
+        m_signature = 2166136261u;
+    }
+
+    void submit(SpriteData &sprite, ColorMap &colorMap, uint32_t offset, int x, int y, uint8_t w, uint8_t h,
+                bool flipX, uint8_t layer, uint8_t depth)
+    {
+        m_stats.submitted++;
+        if (m_count >= DISPLAY_LIST_CAPACITY)
+        {
+            Serial.println("Display list full");
+            return;
+        }
+        DrawCommand &c = m_commands[m_count];
+        c.sprite = &sprite;
+        c.colorMap = &colorMap;
+        c.offset = offset;
+        c.x = x;
+        c.y = y;
+        c.w = w;
+        c.h = h;
+        c.flipX = flipX;
+        c.layer = layer;
+        c.depth = depth;
+        // layer | depth | sprite id (groups same sprite at equal depth only) | submit order (keeps sort stable)
+        c.key = ((uint32_t)layer << 24) | ((uint32_t)depth << 16) | ((uint32_t)spriteId(&sprite) << 8) | m_count;
+        m_count++;
+
+        mixSignature((uint32_t)(uintptr_t)&sprite);
+        mixSignature((uint32_t)(uintptr_t)&colorMap);
+        mixSignature(offset);
+        mixSignature(((uint32_t)(uint16_t)x << 16) | (uint16_t)y);
+        mixSignature((flipX << 16) | (layer << 8) | depth);
+    }
+
+    // hash of everything submitted since begin(), equal hashes draw the same pixels
+    uint32_t getSignature() const
+    {
+        return m_signature;
+    }
+
+    // Occluder needs bool coversRect(int x, int y, int w, int h) const, and is drawn above every command.
+    template <typename Occluder>
+    void execute(LGFX_Sprite &target, const Occluder *occluder)
+    {
+        uint16_t *fb = (uint16_t *)target.getBuffer();
+        if (fb == nullptr)
+            return;
+
+        for (size_t i = 0; i < m_count; i++)
+            m_order[i] = i;
+        std::sort(m_order, m_order + m_count, [this](uint8_t a, uint8_t b)
+                  { return m_commands[a].key < m_commands[b].key; });
+
+        for (size_t i = 0; i < m_count; i++)
+        {
+            const DrawCommand &c = m_commands[m_order[i]];
+            int x0 = c.x - c.w / 2;
+            int y0 = c.y - c.h / 2;
+            if (x0 >= RENDER_WIDTH || y0 >= RENDER_HEIGHT || x0 + c.w <= 0 || y0 + c.h <= 0)
+            {
+                m_stats.culledViewport++;
+                continue;
+            }
+            if (occluder && occluder->coversRect(x0, y0, c.w, c.h))
+            {
+                m_stats.culledOccluded++;
+                continue;
+            }
+            blit(fb, c);
+            m_stats.drawn++;
+        }
+    }
+
+    void execute(LGFX_Sprite &target)
+    {
+        execute<DisplayList>(target, nullptr);
+    }
+
+    bool coversRect(int, int, int, int) const
+    {
+        return false;
+    }
+
+    // also write palette indices here, for translucent layers drawn on top. nullptr to disable
+    void setIndexTarget(uint8_t *indexBuffer)
+    {
+        m_indexBuffer = indexBuffer;
+    }
+
+    const Stats &getStats() const
+    {
+        return m_stats;
+    }
+
+private:
+    DrawCommand m_commands[DISPLAY_LIST_CAPACITY];
+    uint8_t m_order[DISPLAY_LIST_CAPACITY];
+    size_t m_count = 0;
+    Stats m_stats = {0, 0, 0, 0};
+    uint32_t m_signature = 2166136261u;
+    uint8_t *m_indexBuffer = nullptr;
+    const SpriteData *m_sprites[DISPLAY_LIST_SPRITES] = {nullptr};
+
+    // FNV-1a over 32-bit words
+    void mixSignature(uint32_t v)
+    {
+        m_signature = (m_signature ^ v) * 16777619u;
+    }
+
+    uint8_t spriteId(const SpriteData *sprite)
+    {
+        for (uint8_t i = 0; i < DISPLAY_LIST_SPRITES; i++)
+        {
+            if (m_sprites[i] == sprite)
+                return i;
+            if (m_sprites[i] == nullptr)
+            {
+                m_sprites[i] = sprite;
+                return i;
+            }
+        }
+        return DISPLAY_LIST_SPRITES;
+    }
+
+    void blit(uint16_t *fb, const DrawCommand &c)
+    {
+        // prefer the pre-baked mirrored frame, fall back to reading rows backwards
+        uint8_t *ptr = c.flipX ? c.sprite->getMirroredPtr(c.offset, c.w * c.h) : nullptr;
+        bool reversed = false;
+        if (ptr == nullptr)
+        {
+            ptr = c.sprite->getPtr(c.offset, c.w * c.h);
+            reversed = c.flipX;
+        }
+        if (ptr == nullptr)
+            return;
+
+        int x0 = c.x - c.w / 2;
+        int y0 = c.y - c.h / 2;
+        int xs = max(0, -x0);
+        int xe = min((int)c.w, RENDER_WIDTH - x0);
+        int ys = max(0, -y0);
+        int ye = min((int)c.h, RENDER_HEIGHT - y0);
+        for (int y = ys; y < ye; y++)
+        {
+            const uint8_t *row = ptr + y * c.w;
+            uint16_t *dst = fb + (y0 + y) * RENDER_WIDTH + x0;
+            uint8_t *idx = m_indexBuffer ? m_indexBuffer + (y0 + y) * RENDER_WIDTH + x0 : nullptr;
+            for (int x = xs; x < xe; x++)
+            {
+                uint8_t colorIndex = reversed ? row[c.w - 1 - x] : row[x];
+                // same key as GameObject::draw, also covers a palette that hasn't loaded yet
+                uint16_t color = c.colorMap->getColor(colorIndex);
+                if (color == COLOR_TRANSPARENT)
+                    continue;
+                dst[x] = color;
+                if (idx)
+                    idx[x] = colorIndex;
+            }
+        }
+    }
+};
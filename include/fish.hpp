@@ -1,6 +1,7 @@
 #pragma once
 
 #include "gameObject.hpp"
+#include "animation.hpp"
 
 template <size_t WIDTH, size_t HEIGHT>
 class Fish : public GameObject<WIDTH, HEIGHT>
@@ -16,8 +17,42 @@ public:
 
     using GameObject<WIDTH, HEIGHT>::GameObject;
 
+    void setup() override
+    {
+        GameObject<WIDTH, HEIGHT>::setup();
+        m_defaultAnim.setupDefault(DASHING_FRAME_COUNT);
+        setAnimations(m_anim);
+    }
+
+    // clips "dash", "float" and "turn", the "flip" event mirrors the fish.
+    // nullptr goes back to the default clips
+    void setAnimations(const AnimationSet *anim)
+    {
+        m_anim = anim;
+        m_dashClip = getAnimations().findClip("dash");
+        m_floatClip = getAnimations().findClip("float");
+        m_turnClip = getAnimations().findClip("turn");
+        m_flipEvent = getAnimations().getEventId("flip");
+    }
+
+    // not a pointer to m_defaultAnim, fish get moved around in std::vector
+    const AnimationSet &getAnimations() const
+    {
+        return m_anim ? *m_anim : m_defaultAnim;
+    }
+
+    size_t getFrameCount() const
+    {
+        return DASHING_FRAME_COUNT;
+    }
+
     void update(size_t frame) override
     {
+        // ticks since the last update, > 1 when the caller skips ticks. capped at the half-rate stride:
+        // a fish left out under FEWER_FISH resumes where it stopped instead of jumping across the screen
+        size_t dt = (m_prevFrame == 0 || frame <= m_prevFrame) ? 1 : min(frame - m_prevFrame, (size_t)2);
+        m_prevFrame = frame;
+
         if (m_lastFrame == 0 || frame - m_lastFrame >= m_moveDuration)
         {
             m_lastFrame = frame;
@@ -37,19 +72,22 @@ public:
                 if ((m_targetX - this->m_posX) * this->m_scaleX > 0)
                 {
                     m_state = TURNING;
-                    m_moveDuration = TURNING_FRAME_COUNT;
+                    m_moveDuration = clipLength(m_turnClip);
+                    m_flipped = false;
                 }
                 else
                 {
                     m_state = DASHING;
-                    m_moveDuration = DASHING_FRAME_COUNT;
+                    m_moveDuration = clipLength(m_dashClip);
                 }
                 break;
             case TURNING:
                 // Update turning state
-                this->m_scaleX = -this->m_scaleX;
+                // the turn clip has no flip event: flip once it is over
+                if (!m_flipped)
+                    this->m_scaleX = -this->m_scaleX;
                 m_state = DASHING;
-                m_moveDuration = DASHING_FRAME_COUNT;
+                m_moveDuration = clipLength(m_dashClip);
                 break;
             case STRUGGLING:
                 // Update struggling state
@@ -58,23 +96,33 @@ public:
         }
 
         // Update state
+        size_t tick = frame - m_lastFrame;
         switch (m_state)
         {
         case DASHING:
             // Update dashing state
-            this->m_currentFrame = (frame - m_lastFrame) % DASHING_FRAME_COUNT;
-            this->m_posX += m_dashingVelocity * float(m_targetX - m_lastX) / getDistance() / FPS;
-            this->m_posY += m_dashingVelocity * float(m_targetY - m_lastY) / getDistance() / FPS;
+            this->m_currentFrame = clipFrame(m_dashClip, tick);
+            this->m_posX += dt * m_dashingVelocity * float(m_targetX - m_lastX) / getDistance() / FPS;
+            this->m_posY += dt * m_dashingVelocity * float(m_targetY - m_lastY) / getDistance() / FPS;
             break;
         case FLOATING:
             // Update floating state
-            this->m_currentFrame = ((frame - m_lastFrame) % (2 * DASHING_FRAME_COUNT)) / 2;
+            this->m_currentFrame = clipFrame(m_floatClip, tick);
             this->m_posX = m_lastX + (m_targetX - m_lastX) / float(m_moveDuration) * float(frame - m_lastFrame + 1);
             this->m_posY = m_lastY + (m_targetY - m_lastY) / float(m_moveDuration) * float(frame - m_lastFrame + 1);
             break;
         case TURNING:
             // Update turning state
-            this->m_currentFrame = 0; // TODO: implement turning animation
+            this->m_currentFrame = clipFrame(m_turnClip, tick);
+            // fire events of every tick since the last update, skipped ticks included
+            for (size_t t = tick + 1 - min(dt, tick + 1); t <= tick; t++)
+            {
+                if (m_turnClip >= 0 && getAnimations().getClip(m_turnClip).eventAt(t) == m_flipEvent && m_flipEvent != ANIM_NO_EVENT)
+                {
+                    this->m_scaleX = -this->m_scaleX;
+                    m_flipped = true;
+                }
+            }
             break;
         case STRUGGLING:
             // Update struggling state
@@ -98,11 +146,29 @@ protected:
     int m_lastY = 0;
     state m_state = FLOATING;
     size_t m_lastFrame = 0;
+    size_t m_prevFrame = 0;
     size_t m_moveDuration = 5;
     size_t DASHING_FRAME_COUNT = 4;
-    size_t TURNING_FRAME_COUNT = 1;
     size_t STRUGGLING_FRAME_COUNT = 2;
 
+    AnimationSet m_defaultAnim;        // built from DASHING_FRAME_COUNT in setup()
+    const AnimationSet *m_anim = nullptr; // loaded clips shared by every fish of a kind
+    int m_dashClip = -1;
+    int m_floatClip = -1;
+    int m_turnClip = -1;
+    int m_flipEvent = ANIM_NO_EVENT;
+    bool m_flipped = false;
+
+    size_t clipLength(int clip)
+    {
+        return clip >= 0 ? max((size_t)1, getAnimations().getClip(clip).length()) : 1;
+    }
+
+    size_t clipFrame(int clip, size_t tick)
+    {
+        return clip >= 0 ? getAnimations().getClip(clip).frameAt(tick) : 0;
+    }
+
     void chooseTarget()
     {
         bool turn = !(this->m_posX < 10 && this->m_scaleX < 0 || this->m_posX > RENDER_WIDTH - 10 && this->m_scaleX > 0) && (min(this->m_posX, RENDER_WIDTH - this->m_posX) < random(10, 80));
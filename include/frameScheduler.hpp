@@ -0,0 +1,108 @@
+#pragma once
+
+#include <Arduino.h>
+#include "esp_sleep.h"
+#include "renderer.hpp"
+
+#define FRAME_PERIOD_US (uint32_t)(1000000 / FPS)
+#define SCHEDULER_REPORT_FRAMES 100 // 每多少帧打印一次 CPU 占用
+// 1: 空闲时 esp_light_sleep_start（USB CDC 串口会断开），0: vTaskDelay 让出 CPU
+#ifndef IDLE_LIGHT_SLEEP
+#define IDLE_LIGHT_SLEEP 0
+#endif
+
+// Paces loop() to the simulation tick, decides whether a frame needs to be pushed
+// and sleeps the rest of the tick. Reports how much of the wall time the CPU was busy.
+class FrameScheduler
+{
+public:
+    void setup()
+    {
+        m_nextTick = micros();
+        m_windowStart = m_nextTick;
+        m_busyUs = 0;
+        m_frames = 0;
+        m_skipped = 0;
+    }
+
+    uint32_t beginFrame()
+    {
+        m_frameStart = micros();
+        return m_frameStart;
+    }
+
+    // pushesPerFrame > 1 when each push only covers part of the lcd,
+    // the same scene then has to be pushed that many times before it is complete
+    bool needsPush(uint32_t signature, int pushesPerFrame = 1)
+    {
+        if (!m_hasSignature || signature != m_signature)
+        {
+            m_signature = signature;
+            m_hasSignature = true;
+            m_pushes = 0;
+        }
+        return m_pushes < pushesPerFrame;
+    }
+
+    void endFrame(bool pushed)
+    {
+        if (pushed)
+            m_pushes++;
+        else
+            m_skipped++;
+        m_frames++;
+
+        uint32_t now = micros();
+        m_busyUs += now - m_frameStart;
+        m_nextTick += FRAME_PERIOD_US;
+        // fell behind: don't try to catch up with a burst of frames
+        if ((int32_t)(m_nextTick - now) < 0)
+            m_nextTick = now;
+        else
+            sleepUntil(m_nextTick);
+
+        if (m_frames >= SCHEDULER_REPORT_FRAMES)
+        {
+            uint32_t wall = micros() - m_windowStart;
+            m_busyPercent = wall ? 100.0f * m_busyUs / wall : 0;
+            Serial.println("cpu busy: " + String(m_busyPercent) + " %, skipped " + String(m_skipped) + "/" + String(m_frames) + " frames");
+            m_windowStart = micros();
+            m_busyUs = 0;
+            m_frames = 0;
+            m_skipped = 0;
+        }
+    }
+
+    // busy share of the last report window
+    float getBusyPercent() const
+    {
+        return m_busyPercent;
+    }
+
+private:
+    uint32_t m_nextTick = 0;
+    uint32_t m_frameStart = 0;
+    uint32_t m_windowStart = 0;
+    uint32_t m_busyUs = 0;
+    size_t m_frames = 0;
+    size_t m_skipped = 0;
+    float m_busyPercent = 0;
+
+    uint32_t m_signature = 0;
+    bool m_hasSignature = false;
+    int m_pushes = 0;
+
+    void sleepUntil(uint32_t tick)
+    {
+        int32_t wait = (int32_t)(tick - micros());
+        if (wait <= 0)
+            return;
+#if IDLE_LIGHT_SLEEP
+        esp_sleep_enable_timer_wakeup(wait);
+        esp_light_sleep_start();
+#else
+        // round up, oversleeping part of a ms is fine since m_nextTick doesn't drift
+        vTaskDelay(pdMS_TO_TICKS((wait + 999) / 1000));
+#endif
+    }
+};
@@ -6,6 +6,7 @@
 #include "renderer.hpp"
 #include "colorMap.hpp"
 #include "spriteData.hpp"
+#include "displayList.hpp"
 #include <LovyanGFX.hpp>
 #include "esp_heap_caps.h"
 
@@ -13,6 +14,9 @@ template <size_t WIDTH, size_t HEIGHT>
 class GameObject
 {
 public:
+    static constexpr size_t width = WIDTH;
+    static constexpr size_t height = HEIGHT;
+
     virtual void setup()
     {
         if (m_buffer == nullptr) {
@@ -46,6 +50,14 @@ public:
         sprite.pushImageRotateZoom(m_posX, m_posY, WIDTH / 2, HEIGHT / 2, m_rotation, m_scaleX, m_scaleY, WIDTH, HEIGHT, m_buffer, COLOR_TRANSPARENT);
     }
 
+    // retained-mode alternative to draw(): nearer (lower on screen) objects sort in front
+    virtual void submit(DisplayList &list, SpriteData &spriteData, ColorMap &colorMap, uint8_t layer)
+    {
+        size_t offset = m_spriteOffset + m_currentFrame * WIDTH * HEIGHT;
+        uint8_t depth = (uint8_t)max(0, min(255, m_posY));
+        list.submit(spriteData, colorMap, offset, m_posX, m_posY, WIDTH, HEIGHT, m_scaleX < 0, layer, depth);
+    }
+
     void setPos(int x, int y)
     {
         m_posX = x;
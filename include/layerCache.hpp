@@ -0,0 +1,354 @@
+#pragma once
+
+#include <vector>
+#include "renderer.hpp"
+#include "colorMap.hpp"
+#include "spriteData.hpp"
+#include "blendTable.hpp"
+#include "waterDistortion.hpp"
+#include <LovyanGFX.hpp>
+
+// Full-screen rgb565 plate: clear color + a static background image, composited once.
+// Rebuilt only when the palette or position changes, drawn with a single block copy.
+template <size_t WIDTH, size_t HEIGHT>
+class BackgroundPlate
+{
+public:
+    // withIndex: also keep the palette indices, for translucent layers drawn on top
+    void setup(bool withIndex = false)
+    {
+        if (m_plate == nullptr)
+        {
+            m_plate = (uint16_t *)ps_malloc(RENDER_WIDTH * RENDER_HEIGHT * 2);
+        }
+        if (withIndex && m_indexPlate == nullptr)
+        {
+            m_indexPlate = (uint8_t *)ps_malloc(RENDER_WIDTH * RENDER_HEIGHT);
+        }
+    }
+
+    // same center convention as GameObject::setPos
+    void setPos(int x, int y)
+    {
+        if (x != m_posX || y != m_posY)
+        {
+            m_posX = x;
+            m_posY = y;
+            m_valid = false;
+        }
+    }
+
+    // color: native rgb565 as returned by color565(). the plate is copied straight into
+    // the sprite buffer, so it is stored byte-swapped like the palette entries
+    void setClearColor(uint16_t color)
+    {
+        color = __builtin_bswap16(color);
+        if (color != m_clearColor)
+        {
+            m_clearColor = color;
+            m_valid = false;
+        }
+    }
+
+    // distortion: optional water wobble applied while copying, the plate itself stays undistorted
+    void draw(LGFX_Sprite &sprite, SpriteData &spriteData, ColorMap &colorMap, const WaterDistortion *distortion = nullptr)
+    {
+        if (m_plate == nullptr)
+            return;
+        if (!m_valid || m_colorMap != &colorMap || m_paletteVersion != colorMap.getVersion())
+        {
+            rebuild(spriteData, colorMap);
+        }
+        if (distortion && distortion->enabled())
+            distortion->copy((uint16_t *)sprite.getBuffer(), m_plate);
+        else
+            memcpy(sprite.getBuffer(), m_plate, RENDER_WIDTH * RENDER_HEIGHT * 2);
+    }
+
+    // index 0 where only the clear color shows. call after draw(), with the same distortion
+    void drawIndex(uint8_t *dst, const WaterDistortion *distortion = nullptr)
+    {
+        if (m_indexPlate == nullptr || dst == nullptr)
+            return;
+        if (distortion && distortion->enabled())
+            distortion->copy(dst, m_indexPlate);
+        else
+            memcpy(dst, m_indexPlate, RENDER_WIDTH * RENDER_HEIGHT);
+    }
+
+    // byte-swapped, same format as ColorMap::getColor
+    uint16_t getClearColor() const
+    {
+        return m_clearColor;
+    }
+
+    size_t getRebuildCount() const
+    {
+        return m_rebuildCount;
+    }
+
+    ~BackgroundPlate()
+    {
+        if (m_plate)
+        {
+            free(m_plate);
+            m_plate = nullptr;
+        }
+        if (m_indexPlate)
+        {
+            free(m_indexPlate);
+            m_indexPlate = nullptr;
+        }
+    }
+
+private:
+    uint16_t *m_plate = nullptr;
+    uint8_t *m_indexPlate = nullptr;
+    int m_posX = RENDER_WIDTH / 2;
+    int m_posY = RENDER_HEIGHT / 2;
+    uint16_t m_clearColor = 0;
+    bool m_valid = false;
+    const ColorMap *m_colorMap = nullptr;
+    uint32_t m_paletteVersion = 0;
+    size_t m_rebuildCount = 0;
+
+    void rebuild(SpriteData &spriteData, ColorMap &colorMap)
+    {
+        for (int i = 0; i < RENDER_WIDTH * RENDER_HEIGHT; i++)
+        {
+            m_plate[i] = m_clearColor;
+        }
+        if (m_indexPlate)
+        {
+            memset(m_indexPlate, 0, RENDER_WIDTH * RENDER_HEIGHT);
+        }
+
+        uint8_t *ptr = spriteData.getPtr(0, WIDTH * HEIGHT);
+        if (ptr != nullptr)
+        {
+            int x0 = m_posX - (int)WIDTH / 2;
+            int y0 = m_posY - (int)HEIGHT / 2;
+            for (int y = 0; y < (int)HEIGHT; y++)
+            {
+                int dy = y0 + y;
+                if (dy < 0 || dy >= RENDER_HEIGHT)
+                    continue;
+                for (int x = 0; x < (int)WIDTH; x++)
+                {
+                    int dx = x0 + x;
+                    if (dx < 0 || dx >= RENDER_WIDTH)
+                        continue;
+                    uint8_t colorIndex = ptr[y * WIDTH + x];
+                    uint16_t color = colorMap.getColor(colorIndex);
+                    if (color == COLOR_TRANSPARENT)
+                        continue;
+                    m_plate[dy * RENDER_WIDTH + dx] = color;
+                    if (m_indexPlate)
+                        m_indexPlate[dy * RENDER_WIDTH + dx] = colorIndex;
+                }
+            }
+        }
+
+        // without image data keep rebuilding until it arrives
+        m_valid = ptr != nullptr;
+        m_colorMap = &colorMap;
+        m_paletteVersion = colorMap.getVersion();
+        m_rebuildCount++;
+    }
+};
+
+// Static overlay stored as runs of opaque pixels per row.
+// Colors are expanded once per palette change, drawing is one memcpy per run.
+template <size_t WIDTH, size_t HEIGHT>
+class ForegroundMask
+{
+public:
+    struct Span
+    {
+        uint16_t y;
+        uint16_t x;
+        uint16_t len;
+    };
+
+    void setup(SpriteData &spriteData)
+    {
+        if (m_colors == nullptr)
+        {
+            m_colors = (uint16_t *)ps_malloc(WIDTH * HEIGHT * 2);
+        }
+
+        m_spans.clear();
+        m_rowStart.assign(HEIGHT + 1, 0);
+        uint8_t *ptr = spriteData.getPtr(0, WIDTH * HEIGHT);
+        if (ptr == nullptr)
+        {
+            Serial.println("Failed to build foreground mask");
+            return;
+        }
+        for (size_t y = 0; y < HEIGHT; y++)
+        {
+            m_rowStart[y] = m_spans.size();
+            size_t x = 0;
+            while (x < WIDTH)
+            {
+                // index 0 is the transparent key
+                while (x < WIDTH && ptr[y * WIDTH + x] == 0)
+                    x++;
+                size_t start = x;
+                while (x < WIDTH && ptr[y * WIDTH + x] != 0)
+                    x++;
+                if (x > start)
+                    m_spans.push_back({(uint16_t)y, (uint16_t)start, (uint16_t)(x - start)});
+            }
+        }
+        m_rowStart[HEIGHT] = m_spans.size();
+        m_colorMap = nullptr;
+        Serial.println("Foreground mask spans: " + String(m_spans.size()));
+    }
+
+    void setPos(int x, int y)
+    {
+        m_posX = x;
+        m_posY = y;
+    }
+
+    void draw(LGFX_Sprite &sprite, SpriteData &spriteData, ColorMap &colorMap)
+    {
+        if (m_colors == nullptr)
+            return;
+        if (m_colorMap != &colorMap || m_paletteVersion != colorMap.getVersion())
+        {
+            expand(spriteData, colorMap);
+        }
+
+        uint16_t *fb = (uint16_t *)sprite.getBuffer();
+        int x0 = m_posX - (int)WIDTH / 2;
+        int y0 = m_posY - (int)HEIGHT / 2;
+        for (const Span &s : m_spans)
+        {
+            int dy = y0 + s.y;
+            if (dy < 0 || dy >= RENDER_HEIGHT)
+                continue;
+            int dx = x0 + s.x;
+            int len = s.len;
+            int skip = 0;
+            if (dx < 0)
+            {
+                skip = -dx;
+                dx = 0;
+                len -= skip;
+            }
+            if (dx + len > RENDER_WIDTH)
+                len = RENDER_WIDTH - dx;
+            if (len <= 0)
+                continue;
+            const uint16_t *src = &m_colors[s.y * WIDTH + s.x + skip];
+            uint16_t *dst = &fb[dy * RENDER_WIDTH + dx];
+            if (!m_keyed)
+            {
+                memcpy(dst, src, len * 2);
+                continue;
+            }
+            for (int x = 0; x < len; x++)
+            {
+                if (src[x] != COLOR_TRANSPARENT)
+                    dst[x] = src[x];
+            }
+        }
+    }
+
+    // Translucent version of draw(): every overlay pixel is blended over the index buffer
+    // underneath it at the given BlendTable level, one table lookup per pixel.
+    void drawBlended(LGFX_Sprite &sprite, SpriteData &spriteData, const uint8_t *indexBuffer, const BlendTable &table, size_t level)
+    {
+        uint8_t *ptr = spriteData.getPtr(0, WIDTH * HEIGHT);
+        if (ptr == nullptr || indexBuffer == nullptr)
+            return;
+
+        uint16_t *fb = (uint16_t *)sprite.getBuffer();
+        int x0 = m_posX - (int)WIDTH / 2;
+        int y0 = m_posY - (int)HEIGHT / 2;
+        for (const Span &s : m_spans)
+        {
+            int dy = y0 + s.y;
+            if (dy < 0 || dy >= RENDER_HEIGHT)
+                continue;
+            int xs = max((int)s.x, -x0);
+            int xe = min((int)(s.x + s.len), RENDER_WIDTH - x0);
+            const uint8_t *src = ptr + s.y * WIDTH;
+            size_t row = dy * RENDER_WIDTH + x0;
+            for (int x = xs; x < xe; x++)
+            {
+                fb[row + x] = table.blend(level, src[x], indexBuffer[row + x]);
+            }
+        }
+    }
+
+    // true if every pixel of the screen rect is opaque overlay, so anything under it can be skipped
+    bool coversRect(int x, int y, int w, int h) const
+    {
+        int lx = x - (m_posX - (int)WIDTH / 2);
+        int ly = y - (m_posY - (int)HEIGHT / 2);
+        if (m_keyed || m_rowStart.empty() || w <= 0 || h <= 0 || lx < 0 || ly < 0 || lx + w > (int)WIDTH || ly + h > (int)HEIGHT)
+            return false;
+        for (int row = ly; row < ly + h; row++)
+        {
+            bool covered = false;
+            for (size_t i = m_rowStart[row]; i < m_rowStart[row + 1]; i++)
+            {
+                const Span &s = m_spans[i];
+                if (lx >= s.x && lx + w <= s.x + s.len)
+                {
+                    covered = true;
+                    break;
+                }
+            }
+            if (!covered)
+                return false;
+        }
+        return true;
+    }
+
+    const std::vector<Span> &getSpans() const
+    {
+        return m_spans;
+    }
+
+    ~ForegroundMask()
+    {
+        if (m_colors)
+        {
+            free(m_colors);
+            m_colors = nullptr;
+        }
+    }
+
+private:
+    std::vector<Span> m_spans;
+    std::vector<size_t> m_rowStart; // first span of each row, HEIGHT + 1 entries
+    uint16_t *m_colors = nullptr;
+    int m_posX = 0;
+    int m_posY = 0;
+    const ColorMap *m_colorMap = nullptr;
+    uint32_t m_paletteVersion = 0;
+    bool m_keyed = false; // some span pixel maps to COLOR_TRANSPARENT (e.g. palette not loaded), draw per pixel
+
+    void expand(SpriteData &spriteData, ColorMap &colorMap)
+    {
+        uint8_t *ptr = spriteData.getPtr(0, WIDTH * HEIGHT);
+        if (ptr == nullptr)
+            return;
+        m_keyed = false;
+        for (const Span &s : m_spans)
+        {
+            size_t row = s.y * WIDTH;
+            for (size_t x = s.x; x < s.x + s.len; x++)
+            {
+                m_colors[row + x] = colorMap.getColor(ptr[row + x]);
+                m_keyed |= m_colors[row + x] == COLOR_TRANSPARENT;
+            }
+        }
+        m_colorMap = &colorMap;
+        m_paletteVersion = colorMap.getVersion();
+    }
+};
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <Arduino.h>
+#include "renderer.hpp"
+
+#define GOVERNOR_WINDOW 16              // 滚动窗口帧数
+#define GOVERNOR_FRAME_BUDGET_US (uint32_t)(1000000 / FPS) // 一帧的预算，跟着 FPS 走
+#define GOVERNOR_HEADROOM 0.75f         // 低于预算的这个比例才算有余量
+#define GOVERNOR_HOLD_FRAMES 32         // 升级前需持续有余量的帧数
+
+// Watches the rolling frame time and trades visual quality for a steady frame rate.
+// Levels are cumulative: each level keeps every reduction of the levels below it.
+class QualityGovernor
+{
+public:
+    enum level
+    {
+        FULL,              // everything every frame
+        SLOW_DAYNIGHT,     // tint the palette every few frames instead of every pixel every frame
+        HALF_RATE_FISH,    // background fish update every other tick
+        FEWER_FISH,        // only draw part of the background fish
+        PARTIAL_LCD,       // push half of the lcd per frame, alternating
+        LEVEL_COUNT
+    };
+
+    void setup(uint32_t budgetUs = GOVERNOR_FRAME_BUDGET_US)
+    {
+        m_budgetUs = budgetUs;
+        m_level = FULL;
+        m_count = 0;
+        m_index = 0;
+        m_sum = 0;
+        m_headroomFrames = 0;
+        m_cooldown = 0;
+    }
+
+    // Feed the total time of the last frame. Returns true if the level changed.
+    bool update(uint32_t frame_us)
+    {
+        if (m_count == GOVERNOR_WINDOW)
+            m_sum -= m_window[m_index];
+        else
+            m_count++;
+        m_window[m_index] = frame_us;
+        m_sum += frame_us;
+        m_index = (m_index + 1) % GOVERNOR_WINDOW;
+
+        // wait for the window to refill after a change, so one level is judged by its own frames
+        if (m_cooldown > 0)
+        {
+            m_cooldown--;
+            return false;
+        }
+        if (m_count < GOVERNOR_WINDOW)
+            return false;
+
+        uint32_t avg = getAverage();
+        if (avg > m_budgetUs)
+        {
+            m_headroomFrames = 0;
+            if (m_level + 1 < LEVEL_COUNT)
+            {
+                setLevel((level)(m_level + 1), avg);
+                return true;
+            }
+        }
+        else if (avg < m_budgetUs * GOVERNOR_HEADROOM)
+        {
+            if (++m_headroomFrames >= GOVERNOR_HOLD_FRAMES && m_level > FULL)
+            {
+                m_headroomFrames = 0;
+                setLevel((level)(m_level - 1), avg);
+                return true;
+            }
+        }
+        else
+        {
+            m_headroomFrames = 0;
+        }
+        return false;
+    }
+
+    level getLevel() const
+    {
+        return m_level;
+    }
+
+    bool atLeast(level l) const
+    {
+        return m_level >= l;
+    }
+
+    uint32_t getAverage() const
+    {
+        return m_count ? m_sum / m_count : 0;
+    }
+
+    static const char *levelName(level l)
+    {
+        switch (l)
+        {
+        case FULL:
+            return "FULL";
+        case SLOW_DAYNIGHT:
+            return "SLOW_DAYNIGHT";
+        case HALF_RATE_FISH:
+            return "HALF_RATE_FISH";
+        case FEWER_FISH:
+            return "FEWER_FISH";
+        case PARTIAL_LCD:
+            return "PARTIAL_LCD";
+        default:
+            return "UNKNOWN";
+        }
+    }
+
+private:
+    uint32_t m_window[GOVERNOR_WINDOW] = {0};
+    size_t m_count = 0;
+    size_t m_index = 0;
+    uint32_t m_sum = 0;
+    uint32_t m_budgetUs = GOVERNOR_FRAME_BUDGET_US;
+    size_t m_headroomFrames = 0;
+    size_t m_cooldown = 0;
+    level m_level = FULL;
+
+    void setLevel(level l, uint32_t avg)
+    {
+        Serial.println("quality: " + String(levelName(m_level)) + " -> " + String(levelName(l)) +
+                       ", avg frame " + String(avg / 1000.0f) + " ms, budget " + String(m_budgetUs / 1000.0f) + " ms");
+        m_level = l;
+        m_cooldown = GOVERNOR_WINDOW;
+    }
+};
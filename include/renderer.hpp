@@ -36,11 +36,12 @@ public:
         Serial.println("Sprite buffer created");
     }
 
-    void drawFrame(uint32_t draw_us, uint32_t frame_id)
+    // partial: only push half of the lcd rows this frame, alternating top / bottom
+    void drawFrame(uint32_t draw_us, uint32_t frame_id, bool partial = false)
     {
         // sendFrameSerial(draw_us, frame_id);
         uint32_t start = micros();
-        render2lcd();
+        render2lcd(partial ? (frame_id & 1) + 1 : 0);
         Serial.println("render time: " + String(draw_us / 1000.0f) + " ms, frame id: " + String(frame_id));
         Serial.println("push time: " + String((micros() - start) / 1000.0f) + " ms");
     }
@@ -77,10 +78,19 @@ private:
         Serial.write((uint8_t *)m_fb.getBuffer(), RENDER_WIDTH * RENDER_HEIGHT * 2);
     }
 
-    void render2lcd()
+    // half: 0 = whole frame, 1 = top half, 2 = bottom half
+    void render2lcd(int half = 0)
     {
         m_fb.drawString("Hello Sprite", 10, 10);
         m_sp.pushImageRotateZoom(0, 0, 0, 0, 0, PHYSICAL_WIDTH/RENDER_WIDTH, PHYSICAL_HEIGHT/RENDER_HEIGHT, RENDER_WIDTH, RENDER_HEIGHT, (uint16_t*)m_fb.getBuffer());
-        m_sp.pushSprite(0, 0);
+        if (half == 0)
+        {
+            m_sp.pushSprite(0, 0);
+            return;
+        }
+        // sprite rows are contiguous, push a band straight from its buffer
+        int y = (half == 1) ? 0 : PHYSICAL_HEIGHT / 2;
+        uint16_t *band = (uint16_t *)m_sp.getBuffer() + y * PHYSICAL_WIDTH;
+        m_lcd.pushImage(0, y, PHYSICAL_WIDTH, PHYSICAL_HEIGHT / 2, (lgfx::swap565_t *)band);
     }
 };
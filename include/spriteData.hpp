@@ -13,12 +13,55 @@ public:
         }
     }
 
+    // take ownership of an already loaded buffer
+    void setup(uint8_t *data, size_t size)
+    {
+        if (m_data)
+        {
+            free(m_data);
+        }
+        if (m_mirror)
+        {
+            free(m_mirror);
+            m_mirror = nullptr;
+        }
+        m_data = data;
+        m_size = size;
+    }
+
+    // pre-bake horizontally mirrored copies of every width x height frame,
+    // so flipped sprites are drawn with a plain forward copy
+    void bakeMirror(size_t width, size_t height)
+    {
+        if (!m_data || width * height == 0)
+            return;
+        if (!m_mirror)
+            m_mirror = (uint8_t *)ps_malloc(m_size);
+        if (!m_mirror)
+        {
+            Serial.println("Failed to allocate mirrored sprite");
+            return;
+        }
+        size_t rows = m_size / width;
+        for (size_t y = 0; y < rows; y++)
+        {
+            const uint8_t *src = &m_data[y * width];
+            uint8_t *dst = &m_mirror[y * width];
+            for (size_t x = 0; x < width; x++)
+                dst[x] = src[width - 1 - x];
+        }
+    }
+
     ~SpriteData()
     {
         if (m_data)
         {
             free(m_data);
         }
+        if (m_mirror)
+        {
+            free(m_mirror);
+        }
     }
 
     bool get(uint8_t &data, size_t index, size_t length)
@@ -40,8 +83,19 @@ public:
         return &m_data[index];
     }
 
+    // same layout as getPtr, nullptr if bakeMirror() hasn't run
+    uint8_t *getMirroredPtr(size_t index, size_t length)
+    {
+        if (!m_mirror || index + length > m_size)
+        {
+            return nullptr;
+        }
+        return &m_mirror[index];
+    }
+
 private:
     // store color index. lookup color map for real color.
     uint8_t *m_data = nullptr;
+    uint8_t *m_mirror = nullptr;
     size_t m_size = 0;
 };
\ No newline at end of file
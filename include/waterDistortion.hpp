@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Arduino.h>
+#include "renderer.hpp"
+
+#define DISTORTION_TABLE_SIZE 64 // 一个正弦周期的采样数，必须是 2 的幂
+
+// Underwater wobble: every row (and optionally every column) gets an integer offset
+// taken from a precomputed sine table, so applying it is a shifted memcpy per row.
+class WaterDistortion
+{
+public:
+    // amplitude: max offset in pixels, 0 turns the effect off
+    // wavelength: rows (or columns) per sine period
+    // ticksPerStep: ticks between one-step advances of the wave, larger is slower
+    void setup(int amplitude, int wavelength = 32, int ticksPerStep = 1, bool columns = false)
+    {
+        for (int i = 0; i < DISTORTION_TABLE_SIZE; i++)
+        {
+            m_sine[i] = (int8_t)round(127 * sin(2 * M_PI * i / DISTORTION_TABLE_SIZE));
+        }
+        m_amplitude = amplitude;
+        m_wavelength = max(1, wavelength);
+        m_ticksPerStep = max(1, ticksPerStep);
+        m_columns = columns;
+        m_phase = 0;
+        update(0);
+    }
+
+    void update(size_t frame)
+    {
+        m_phase = (frame / m_ticksPerStep) & (DISTORTION_TABLE_SIZE - 1);
+        bool changed = false;
+        for (int y = 0; y < RENDER_HEIGHT; y++)
+        {
+            int8_t off = offsetAt(y);
+            changed |= off != m_rowOffset[y];
+            m_rowOffset[y] = off;
+        }
+        for (int x = 0; x < RENDER_WIDTH; x++)
+        {
+            int8_t off = m_columns ? offsetAt(x) : 0;
+            changed |= off != m_colOffset[x];
+            m_colOffset[x] = off;
+        }
+        if (changed)
+            m_version++;
+    }
+
+    bool enabled() const
+    {
+        return m_amplitude != 0;
+    }
+
+    // bumped only when the offset tables actually change, 0 when disabled
+    uint32_t getVersion() const
+    {
+        return enabled() ? m_version + 1 : 0;
+    }
+
+    // copy a full-screen RENDER_WIDTH x RENDER_HEIGHT buffer with the offsets applied, edges clamp
+    template <typename T>
+    void copy(T *dst, const T *src) const
+    {
+        if (!m_columns)
+        {
+            for (int y = 0; y < RENDER_HEIGHT; y++)
+            {
+                copyRow(dst + y * RENDER_WIDTH, src + y * RENDER_WIDTH, m_rowOffset[y]);
+            }
+            return;
+        }
+
+        for (int y = 0; y < RENDER_HEIGHT; y++)
+        {
+            T *d = dst + y * RENDER_WIDTH;
+            int off = m_rowOffset[y];
+            for (int x = 0; x < RENDER_WIDTH; x++)
+            {
+                int sx = constrain(x - off, 0, RENDER_WIDTH - 1);
+                int sy = constrain(y + m_colOffset[x], 0, RENDER_HEIGHT - 1);
+                d[x] = src[sy * RENDER_WIDTH + sx];
+            }
+        }
+    }
+
+private:
+    int8_t m_sine[DISTORTION_TABLE_SIZE];
+    int8_t m_rowOffset[RENDER_HEIGHT] = {0};
+    int8_t m_colOffset[RENDER_WIDTH] = {0};
+    int m_amplitude = 0;
+    int m_wavelength = 32;
+    int m_ticksPerStep = 1;
+    bool m_columns = false;
+    uint32_t m_phase = 0;
+    uint32_t m_version = 0;
+
+    int8_t offsetAt(int i) const
+    {
+        int index = (i * DISTORTION_TABLE_SIZE / m_wavelength + m_phase) & (DISTORTION_TABLE_SIZE - 1);
+        // round to nearest, truncating only reaches ±amplitude at the very peak
+        int v = m_sine[index] * m_amplitude;
+        return (int8_t)((v + (v >= 0 ? 63 : -63)) / 127);
+    }
+
+    // dst[x] = src[x - off]
+    template <typename T>
+    static void copyRow(T *dst, const T *src, int off)
+    {
+        if (off >= RENDER_WIDTH || off <= -RENDER_WIDTH)
+            off = off > 0 ? RENDER_WIDTH - 1 : 1 - RENDER_WIDTH;
+        if (off >= 0)
+        {
+            memcpy(dst + off, src, (RENDER_WIDTH - off) * sizeof(T));
+            for (int x = 0; x < off; x++)
+                dst[x] = src[0];
+        }
+        else
+        {
+            memcpy(dst, src - off, (RENDER_WIDTH + off) * sizeof(T));
+            for (int x = RENDER_WIDTH + off; x < RENDER_WIDTH; x++)
+                dst[x] = src[RENDER_WIDTH - 1];
+        }
+    }
+};
+
+// Times one frame of plate copy without distortion, with row offsets and with row + column offsets.
+inline void benchmarkDistortion(int amplitude, int wavelength)
+{
+    const int frames = 50;
+    uint16_t *src = (uint16_t *)ps_malloc(RENDER_WIDTH * RENDER_HEIGHT * 2);
+    uint16_t *dst = (uint16_t *)ps_malloc(RENDER_WIDTH * RENDER_HEIGHT * 2);
+    if (!src || !dst)
+    {
+        Serial.println("Failed to allocate distortion benchmark buffers");
+        free(src);
+        free(dst);
+        return;
+    }
+    for (int i = 0; i < RENDER_WIDTH * RENDER_HEIGHT; i++)
+        src[i] = i;
+
+    uint32_t start = micros();
+    for (int f = 0; f < frames; f++)
+        memcpy(dst, src, RENDER_WIDTH * RENDER_HEIGHT * 2);
+    uint32_t plain_us = (micros() - start) / frames;
+
+    WaterDistortion rows, cols;
+    rows.setup(amplitude, wavelength, 1, false);
+    cols.setup(amplitude, wavelength, 1, true);
+    start = micros();
+    for (int f = 0; f < frames; f++)
+    {
+        rows.update(f);
+        rows.copy(dst, src);
+    }
+    uint32_t rows_us = (micros() - start) / frames;
+
+    start = micros();
+    for (int f = 0; f < frames; f++)
+    {
+        cols.update(f);
+        cols.copy(dst, src);
+    }
+    uint32_t cols_us = (micros() - start) / frames;
+
+    Serial.println("distortion benchmark (per frame): memcpy " + String(plain_us) + " us, rows " + String(rows_us) +
+                   " us, rows + columns " + String(cols_us) + " us");
+    free(src);
+    free(dst);
+}
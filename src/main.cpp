@@ -10,15 +10,42 @@
 #include "colorMap.hpp"
 #include "gameObject.hpp"
 #include "fish.hpp"
+#include "qualityGovernor.hpp"
+#include "layerCache.hpp"
+#include "displayList.hpp"
+#include "assetManager.hpp"
+#include "frameScheduler.hpp"
+#include "blendTable.hpp"
+#include "waterDistortion.hpp"
+
+#define DAYNIGHT_SLOW_INTERVAL 8 // SLOW_DAYNIGHT 下每隔几帧重算一次调色板
+#define FEWER_FISH_COUNT 2       // FEWER_FISH 下保留的孔雀鱼数量
+#define FG_ALPHA_LEVEL -1        // 前景透明度：-1 不透明，0 ~ BLEND_LEVELS-1 半透明
+// #define BLEND_BENCHMARK          // 调色板加载后跑一次查表 vs 算术混合的对比
+#define WATER_AMPLITUDE 1        // 背景水波最大偏移（像素），0 关闭
+#define WATER_WAVELENGTH 40      // 每个波长的行数
+#define WATER_TICKS_PER_STEP 2   // 水波每隔几帧前进一步，越大越慢
+#define WATER_COLUMNS false      // 是否同时做列偏移（逐像素，更贵）
+// #define DISTORTION_BENCHMARK     // 启动时跑一次水波拷贝的耗时对比
+// #define ASSET_SLOW_MS 500        // 每个资源文件额外延时（毫秒），用来观察渐进式启动
 
 Renderer renderer;
 SpriteData bgData, fgData, clownfishData, longfishData, guppyData;
-ColorMap colorMap;
-GameObject<160, 120> bg;
-GameObject<160, 40> fg;
+ColorMap colorMap, tintedMap;
+BackgroundPlate<160, 120> bg;
+ForegroundMask<160, 40> fg;
 ClownFish clownfish;
 std::vector<Guppy> guppies;
 LongFish longfish;
+AnimationSet clownfishAnim, longfishAnim, guppyAnim;
+QualityGovernor governor;
+DisplayList displayList;
+AssetManager assets;
+FrameScheduler scheduler;
+BlendTable blendTable;
+WaterDistortion water;
+uint8_t *indexFb = nullptr; // 半透明层用的调色板索引缓冲
+AssetHandle paletteAsset = -1, bgAsset = -1; // 两者都到了才算第一帧真正的画面
 
 void listDir(fs::FS &fs, const char *dirname, uint8_t levels)
 {
@@ -79,26 +106,100 @@ void applyDayNight(LGFX_Sprite &spr, float brightness, float r_scale, float g_sc
     }
 }
 
+void getDayNight(float &brightness, float &r_scale, float &g_scale, float &b_scale)
+{
+    float t3 = (millis() % 10000) / 10000.0f; // 0~1
+
+    // 亮度曲线（白天亮，晚上暗）
+    brightness = max(1.0f + 0.2f * sin(t3 * 2 * M_PI), 1.0);
+
+    // 色温曲线（傍晚偏暖，夜晚偏冷）
+    r_scale = 1.0f;
+    g_scale = 1.0f - 0.2f * sin(t3 * 2 * M_PI + M_PI / 2);
+    b_scale = 1.0f - 0.3f * sin(t3 * 2 * M_PI + M_PI / 2);
+}
+
 void setup()
 {
     // 高波特率，带宽更高
     Serial.begin(2000000);
-    delay(3000);
+    // 最多等 3 秒串口连上，不再固定延时
+    while (!Serial && millis() < 3000)
+        delay(10);
     Serial.println("Serial started");
     LittleFS.begin();
 
     renderer.setup();
 
-    bgData.setup("/bg.bin");
-    fgData.setup("/fg.bin");
-
-    clownfishData.setup("/fish/clownfish.bin");
-    longfishData.setup("/fish/longfish.bin");
-    guppyData.setup("/fish/guppy.bin");
+    bg.setup(FG_ALPHA_LEVEL >= 0);
+    if (FG_ALPHA_LEVEL >= 0)
+    {
+        indexFb = (uint8_t *)ps_malloc(RENDER_WIDTH * RENDER_HEIGHT);
+        blendTable.setup();
+        displayList.setIndexTarget(indexFb);
+    }
+    bg.setPos(80, 60);
+    bg.setClearColor(renderer.m_fb.color565(128, 0, 0));
+    fg.setPos(80, 100);
+    water.setup(WATER_AMPLITUDE, WATER_WAVELENGTH, WATER_TICKS_PER_STEP, WATER_COLUMNS);
+#ifdef DISTORTION_BENCHMARK
+    benchmarkDistortion(max(1, WATER_AMPLITUDE), WATER_WAVELENGTH);
+#endif
 
-    colorMap.setup("/colormaps/colormap.bin");
-    bg.setup();
-    fg.setup();
+    // 后台按优先级加载：调色板和背景先到，鱼随后，loop() 先画已就绪的部分
+    paletteAsset = assets.add("/colormaps/colormap.bin", 0, [](uint8_t *data, size_t size) {
+        colorMap.setup((uint16_t *)data, size);
+        tintedMap.copy(colorMap);
+        free(data);
+#ifdef BLEND_BENCHMARK
+        benchmarkBlend(colorMap, bg.getClearColor());
+#endif
+    });
+    bgAsset = assets.add("/bg.bin", 1, [](uint8_t *data, size_t size) {
+        bgData.setup(data, size);
+    });
+    assets.add("/fg.bin", 2, [](uint8_t *data, size_t size) {
+        fgData.setup(data, size);
+        fg.setup(fgData);
+    });
+    assets.add("/fish/clownfish.bin", 3, [](uint8_t *data, size_t size) {
+        clownfishData.setup(data, size);
+        clownfishData.bakeMirror(ClownFish::width, ClownFish::height);
+    });
+    assets.add("/fish/longfish.bin", 3, [](uint8_t *data, size_t size) {
+        longfishData.setup(data, size);
+        longfishData.bakeMirror(LongFish::width, LongFish::height);
+    });
+    assets.add("/fish/guppy.bin", 3, [](uint8_t *data, size_t size) {
+        guppyData.setup(data, size);
+        guppyData.bakeMirror(Guppy::width, Guppy::height);
+    });
+    // 动画片段声明，编译成逐帧查找表；没加载到之前鱼用默认片段
+    assets.add("/fish/clownfish.anim.txt", 4, [](uint8_t *data, size_t size) {
+        clownfishAnim.setupDefault(clownfish.getFrameCount());
+        clownfishAnim.setup((const char *)data, size);
+        free(data);
+        clownfish.setAnimations(&clownfishAnim);
+    });
+    assets.add("/fish/longfish.anim.txt", 4, [](uint8_t *data, size_t size) {
+        longfishAnim.setupDefault(longfish.getFrameCount());
+        longfishAnim.setup((const char *)data, size);
+        free(data);
+        longfish.setAnimations(&longfishAnim);
+    });
+    assets.add("/fish/guppy.anim.txt", 4, [](uint8_t *data, size_t size) {
+        guppyAnim.setupDefault(guppies.empty() ? 1 : guppies[0].getFrameCount());
+        guppyAnim.setup((const char *)data, size);
+        free(data);
+        for (auto &guppy : guppies)
+            guppy.setAnimations(&guppyAnim);
+    });
+#ifdef ASSET_SLOW_MS
+    static SlowFileBackend slowBackend(ASSET_SLOW_MS);
+    assets.start(&slowBackend);
+#else
+    assets.start();
+#endif
 
     clownfish.setup();
     longfish.setup();
@@ -113,47 +214,119 @@ void setup()
     {
         guppies[i].setPos(80 + i * 10, random(20, 100));
     }
+    governor.setup();
+    scheduler.setup();
 }
 
 void loop()
 {
     static uint32_t frame_id = 0;
+    static bool firstFrameReported = false;
+    static bool tintValid = false;
+    static bool fullSceneReported = false;
 
     // ===== 绘制开始计时 =====
-    uint32_t t0 = micros();
+    // 资源回调（调色板、前景分段、镜像帧、动画编译）也算进 CPU 占用
+    uint32_t t0 = scheduler.beginFrame();
 
-    // fill with blue
-    renderer.m_fb.fillScreen(renderer.m_fb.color565(128, 0, 0));
-    bg.setPos(80, 60);
-    bg.draw(renderer.m_fb, bgData, colorMap);
+    assets.poll();
+
+    float brightness, r_scale, g_scale, b_scale;
+    // SLOW_DAYNIGHT: 每隔几帧把昼夜色调烘焙进调色板，代替逐像素处理
+    bool slowDayNight = governor.atLeast(QualityGovernor::SLOW_DAYNIGHT);
+    if (!slowDayNight)
+    {
+        tintValid = false;
+        getDayNight(brightness, r_scale, g_scale, b_scale);
+    }
+    else if (!tintValid || frame_id % DAYNIGHT_SLOW_INTERVAL == 0)
+    {
+        getDayNight(brightness, r_scale, g_scale, b_scale);
+        tintedMap.tint(colorMap, brightness, r_scale, g_scale, b_scale);
+        tintValid = true;
+    }
+    ColorMap &palette = slowDayNight ? tintedMap : colorMap;
+
+    displayList.begin();
 
     clownfish.update(frame_id);
-    clownfish.draw(renderer.m_fb, clownfishData, colorMap);
+    clownfish.submit(displayList, clownfishData, palette, LAYER_FISH);
 
     longfish.update(frame_id);
-    longfish.draw(renderer.m_fb, longfishData, colorMap);
+    longfish.submit(displayList, longfishData, palette, LAYER_FISH);
 
-    for (auto &guppy : guppies)
+    size_t guppyCount = governor.atLeast(QualityGovernor::FEWER_FISH) ? min(guppies.size(), (size_t)FEWER_FISH_COUNT) : guppies.size();
+    bool halfRate = governor.atLeast(QualityGovernor::HALF_RATE_FISH);
+    for (size_t i = 0; i < guppyCount; i++)
     {
-        guppy.update(frame_id);
-        guppy.draw(renderer.m_fb, guppyData, colorMap);
+        // 错开更新，每帧只有一半的孔雀鱼在动
+        if (!halfRate || (frame_id + i) % 2 == 0)
+            guppies[i].update(frame_id);
+        guppies[i].submit(displayList, guppyData, palette, LAYER_FISH);
     }
 
-    fg.setPos(80, 100);
-    fg.draw(renderer.m_fb, fgData, colorMap);
+    water.update(frame_id);
 
-    float t3 = (millis() % 10000) / 10000.0f; // 0~1
+    // 画面签名：鱼的绘制命令 + 调色板版本 + 逐像素昼夜参数 + 已加载资源数 + 水波偏移表版本，不变就不用重画和推屏
+    uint32_t signature = displayList.getSignature() ^ (palette.getVersion() * 2654435761u) ^ (assets.getDoneCount() << 24) ^
+                         (water.getVersion() * 40503u);
+    if (!slowDayNight)
+    {
+        signature ^= ((uint32_t)(brightness * 64) << 16) ^ ((uint32_t)(g_scale * 64) << 8) ^ (uint32_t)(b_scale * 64);
+    }
+    bool partial = governor.atLeast(QualityGovernor::PARTIAL_LCD);
+    if (!scheduler.needsPush(signature, partial ? 2 : 1))
+    {
+        scheduler.endFrame(false);
+        frame_id++;
+        return;
+    }
 
-    // 亮度曲线（白天亮，晚上暗）
-    float brightness = max(1.0f + 0.2f * sin(t3 * 2 * M_PI), 1.0);
+    // 清屏 + 背景：缓存好的整屏底图，一次拷贝
+    bg.draw(renderer.m_fb, bgData, palette, &water);
 
-    // 色温曲线（傍晚偏暖，夜晚偏冷）
-    float r_scale = 1.0f;
-    float g_scale = 1.0f - 0.2f * sin(t3 * 2 * M_PI + M_PI / 2);
-    float b_scale = 1.0f - 0.3f * sin(t3 * 2 * M_PI + M_PI / 2);
+    if (FG_ALPHA_LEVEL >= 0)
+    {
+        // 半透明前景：鱼被挡住也要画，混合时查索引缓冲
+        bg.drawIndex(indexFb, &water);
+        displayList.execute(renderer.m_fb);
+        blendTable.update(palette, bg.getClearColor());
+        fg.drawBlended(renderer.m_fb, fgData, indexFb, blendTable, FG_ALPHA_LEVEL);
+    }
+    else
+    {
+        // 按深度排序，裁掉屏幕外和被前景完全挡住的鱼
+        displayList.execute(renderer.m_fb, &fg);
+        fg.draw(renderer.m_fb, fgData, palette);
+    }
 
-    applyDayNight(renderer.m_fb, brightness, r_scale, g_scale, b_scale);
+    if (!slowDayNight)
+    {
+        applyDayNight(renderer.m_fb, brightness, r_scale, g_scale, b_scale);
+    }
 
     uint32_t draw_us = micros() - t0;
-    renderer.drawFrame(draw_us, frame_id++);
+    const DisplayList::Stats &stats = displayList.getStats();
+    Serial.println("draw commands: " + String(stats.submitted) + " submitted, " + String(stats.culledViewport) + " offscreen, " +
+                   String(stats.culledOccluded) + " occluded, " + String(stats.drawn) + " drawn");
+    renderer.drawFrame(draw_us, frame_id, partial);
+
+    // 启动耗时从上电算起，括号里是从开始加载资源算起
+    // 第一帧：调色板和背景都已画上的第一次推屏，之前推的只是清屏色
+    if (!firstFrameReported && assets.isReady(paletteAsset) && assets.isReady(bgAsset))
+    {
+        firstFrameReported = true;
+        Serial.println("time to first frame: " + String(millis()) + " ms (" + String(millis() - assets.getStartMs()) +
+                       " ms after asset load start)");
+    }
+    if (!fullSceneReported && assets.allDone())
+    {
+        fullSceneReported = true;
+        Serial.println("time to full scene: " + String(millis()) + " ms (" + String(millis() - assets.getStartMs()) +
+                       " ms after asset load start)");
+    }
+    // 只统计真正推屏的帧，跳过的帧不算余量
+    governor.update(micros() - t0);
+    scheduler.endFrame(true);
+    frame_id++;
 }